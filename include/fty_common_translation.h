@@ -29,3 +29,5 @@ typedef struct _fty_common_translation_base_t fty_common_translation_base_t;
 
 //  Public classes, each with its own header file
 #include "fty_common_translation_base.h"
+#include "fty_common_translation_message.h"
+#include "fty_common_translation_stream.h"
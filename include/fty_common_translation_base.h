@@ -50,6 +50,9 @@ typedef enum
 #include <string>
 #include <vector>
 
+class TranslationArg;
+class TranslationMessage;
+
 class Translation
 {
 public:
@@ -80,6 +83,10 @@ private:
     void loadLanguage(const std::string& language);
     // get translated text inner function
     std::string getTranslatedText(const size_t order, const std::string& json);
+    std::string getTranslatedText(
+        const size_t order, const std::string& key, const TranslationArg* args, const size_t args_count);
+    // get translation of key with fallback to default language, throws if key is not known
+    const std::string& findTranslation(const size_t order, const std::string& key) const;
 
 public:
     // singleton, deleted functions should be public for better error handling
@@ -89,9 +96,15 @@ public:
     void configure(const std::string& agent_name, const std::string& path, const std::string& file_prefix);
     // change default used language
     void changeLanguage(const std::string& language);
+    // get language order of loaded language, throws LanguageNotLoadedException if language is not loaded
+    size_t findLanguage(const std::string& language) const;
     // get translated text from selected language
     std::string getTranslatedText(const std::string& json);
     std::string getTranslatedText(const TRANSLATION_CONFIGURATION& conf, const std::string& json);
+    // get translated text from selected language directly from key and variables, see translation::translate()
+    std::string getTranslatedText(const std::string& language, const TranslationMessage& message);
+    std::string getTranslatedText(
+        const std::string& language, const std::string& key, const TranslationArg* args, const size_t args_count);
     class InvalidFileException
     {
     };
@@ -0,0 +1,148 @@
+/*  =========================================================================
+    fty_common_translation_message - Typed translation messages
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include "fty_common_translation_base.h"
+
+#ifdef __cplusplus
+
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class TranslationMessage;
+
+// Named variable of translation message, value is either plain text or nested message translated to the same language
+class TranslationArg
+{
+public:
+    TranslationArg(std::string name, std::string value)
+        : name_(std::move(name))
+        , value_(std::move(value))
+    {
+    }
+
+    // defined below TranslationMessage, it needs complete type
+    TranslationArg(std::string name, TranslationMessage message);
+
+    const std::string& name() const
+    {
+        return name_;
+    }
+
+    const std::string& value() const
+    {
+        return value_;
+    }
+
+    // nested message or nullptr for plain text
+    const TranslationMessage* message() const
+    {
+        return message_.get();
+    }
+
+private:
+    std::string                               name_;
+    std::string                               value_;
+    std::shared_ptr<const TranslationMessage> message_;
+};
+
+// Translation key with its variables, typed equivalent of { "key" : ..., "variables" : { ... } }
+class TranslationMessage
+{
+public:
+    explicit TranslationMessage(std::string key, std::vector<TranslationArg> args = {})
+        : key_(std::move(key))
+        , args_(std::move(args))
+    {
+    }
+
+    const std::string& key() const
+    {
+        return key_;
+    }
+
+    const std::vector<TranslationArg>& args() const
+    {
+        return args_;
+    }
+
+private:
+    std::string                 key_;
+    std::vector<TranslationArg> args_;
+};
+
+inline TranslationArg::TranslationArg(std::string name, TranslationMessage message)
+    : name_(std::move(name))
+    , message_(std::make_shared<const TranslationMessage>(std::move(message)))
+{
+}
+
+// Variadic helpers to translate without producing and parsing JSON, e.g.
+//     translation::translate("cs_CZ", "Device {{name}} is {{state}}",
+//         translation::arg("name", name), translation::arg("state", translation::message("offline")));
+namespace translation {
+
+// create named variable from text, character, bool, number or nested message
+template <typename T>
+TranslationArg arg(std::string name, T&& value)
+{
+    using Type = std::decay_t<T>;
+    if constexpr (std::is_same_v<Type, TranslationMessage> || std::is_convertible_v<T, std::string>) {
+        return TranslationArg(std::move(name), std::forward<T>(value));
+    } else if constexpr (std::is_convertible_v<T, std::string_view>) {
+        return TranslationArg(std::move(name), std::string(std::string_view(value)));
+    } else if constexpr (std::is_same_v<Type, char>) {
+        return TranslationArg(std::move(name), std::string(1, value));
+    } else if constexpr (std::is_same_v<Type, bool>) {
+        return TranslationArg(std::move(name), value ? "true" : "false");
+    } else {
+        // wide characters would end up as numbers
+        static_assert(std::is_arithmetic_v<Type> && !std::is_same_v<Type, wchar_t> && !std::is_same_v<Type, char16_t> &&
+                          !std::is_same_v<Type, char32_t>,
+            "translation variable must be text, character, bool, number or TranslationMessage");
+        return TranslationArg(std::move(name), std::to_string(value));
+    }
+}
+
+// create nested message
+template <typename... Args>
+TranslationMessage message(std::string key, Args&&... args)
+{
+    return TranslationMessage(std::move(key), {std::forward<Args>(args)...});
+}
+
+// get translated text from selected language, throws the same exceptions as Translation::getTranslatedText()
+template <typename... Args>
+std::string translate(const std::string& language, const std::string& key, Args&&... args)
+{
+    const std::array<TranslationArg, sizeof...(Args)> array = {std::forward<Args>(args)...};
+    return Translation::getInstance().getTranslatedText(language, key, array.data(), array.size());
+}
+
+} // namespace translation
+
+#endif // __cplusplus
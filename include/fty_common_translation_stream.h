@@ -0,0 +1,78 @@
+/*  =========================================================================
+    fty_common_translation_stream - Streaming translation of JSON documents
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include "fty_common_translation_base.h"
+#include <stddef.h>
+
+#ifdef __cplusplus
+
+#include <atomic>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+
+// Translates every { "key" : ..., "variables" : ... } object found in a JSON document into the translated string
+// while the document is being read. Only the chunks in flight are kept in memory, whatever the document size.
+// Objects which can't be translated (unknown key, corrupted object, bigger than max_object_size) are copied as is.
+// The language must be loaded beforehand (see Translation::configure() and Translation::changeLanguage()).
+class TranslationStream
+{
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE      = 1024 * 1024;
+    static constexpr size_t DEFAULT_MAX_OBJECT_SIZE = 64 * 1024;
+
+    // threads == 0 uses all available cores, chunks are always written in input order
+    TranslationStream(const std::string& language, size_t threads = 1, size_t chunk_size = DEFAULT_CHUNK_SIZE,
+        size_t max_object_size = DEFAULT_MAX_OBJECT_SIZE);
+
+    // translate whole input into output, returns number of translated objects
+    // throws Translation::LanguageNotLoadedException before anything is read when language is not loaded
+    size_t translate(std::istream& input, std::ostream& output);
+    size_t translate(int input_fd, int output_fd);
+
+    class IOException
+    {
+    };
+
+private:
+    std::string language_;
+    size_t      threads_;
+    size_t      chunk_size_;
+    size_t      max_object_size_;
+    // number of objects translated by the current translate() call
+    std::atomic<size_t> translated_;
+
+    size_t translate(
+        const std::function<size_t(char*, size_t)>& read, const std::function<void(const std::string&)>& write);
+};
+
+extern "C" {
+#endif
+
+// Wrapper for translating whole stream, threads == 0 uses all available cores
+int translation_translate_stream(const char* language, int input_fd, int output_fd, size_t threads);
+
+#ifdef __cplusplus
+}
+#endif
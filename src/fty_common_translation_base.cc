@@ -20,6 +20,7 @@
 */
 
 #include "fty_common_translation_base.h"
+#include "fty_common_translation_message.h"
 #include <fty_common.h>
 #include <algorithm>
 #include <cctype>
@@ -44,11 +45,75 @@ std::string Translation::getTranslatedText(const std::string& json)
 
 std::string Translation::getTranslatedText(const TRANSLATION_CONFIGURATION& conf, const std::string& json)
 {
-    auto order_it = language_list_ordering_.find(conf.language);
+    return getTranslatedText(findLanguage(conf.language), json);
+}
+
+
+std::string Translation::getTranslatedText(const std::string& language, const TranslationMessage& message)
+{
+    return getTranslatedText(findLanguage(language), message.key(), message.args().data(), message.args().size());
+}
+
+
+std::string Translation::getTranslatedText(
+    const std::string& language, const std::string& key, const TranslationArg* args, const size_t args_count)
+{
+    return getTranslatedText(findLanguage(language), key, args, args_count);
+}
+
+
+size_t Translation::findLanguage(const std::string& language) const
+{
+    auto order_it = language_list_ordering_.find(language);
     if (order_it == language_list_ordering_.end()) {
         throw LanguageNotLoadedException();
     }
-    return getTranslatedText(order_it->second, json);
+    return order_it->second;
+}
+
+
+const std::string& Translation::findTranslation(const size_t order, const std::string& key) const
+{
+    auto mapping = language_translations_.find(key);
+    if (language_translations_.end() == mapping) {
+        throw TranslationNotFoundException();
+    }
+    const std::string& retval = mapping->second.at(order);
+    if (retval.empty()) {
+        // fallback to default language
+        return mapping->second.at(0);
+    }
+    return retval;
+}
+
+
+static void replaceVariable(std::string& target, const std::string& name, const std::string& value)
+{
+    const std::string key = "{{" + name + "}}";
+    size_t            n   = 0;
+    while ((n = target.find(key, n)) != std::string::npos) {
+        target.replace(n, key.size(), value);
+        n += value.size();
+    }
+}
+
+
+std::string Translation::getTranslatedText(
+    const size_t order, const std::string& key, const TranslationArg* args, const size_t args_count)
+{
+    std::string retval = findTranslation(order, key);
+    for (size_t i = 0; i < args_count; ++i) {
+        const TranslationArg& arg = args[i];
+        if (arg.message()) {
+            // nested messages are translated to the same language
+            const TranslationMessage& message = *arg.message();
+            replaceVariable(retval, arg.name(),
+                getTranslatedText(order, message.key(), message.args().data(), message.args().size()));
+        } else {
+            replaceVariable(retval, arg.name(), arg.value());
+        }
+    }
+    return retval;
 }
 
 
@@ -92,15 +157,7 @@ std::string Translation::getTranslatedText(const size_t order, const std::string
         throw std::logic_error("Not implemented");
     }
     // find translation string matching translation_key
-    auto mapping = language_translations_.find(value);
-    if (language_translations_.end() == mapping) {
-        throw TranslationNotFoundException();
-    }
-    retval = mapping->second.at(order);
-    if (retval.empty()) {
-        // fallback to default language
-        retval = mapping->second.at(0);
-    }
+    retval = findTranslation(order, value);
     // load variables if present
     begin = end + 1;
     if (JSON::getNextObject(json, begin) == JT_String) {
@@ -133,7 +190,6 @@ std::string Translation::getTranslatedText(const size_t order, const std::string
             // detect whether there are no more variables
             if (done)
                 break;
-            key   = "{{" + key + "}}";
             begin = end + 1;
             switch (JSON::getNextObject(json, begin)) {
                 case JT_String:
@@ -149,11 +205,7 @@ std::string Translation::getTranslatedText(const size_t order, const std::string
                 case JT_Object_End:
                     throw CorruptedLineException();
             }
-            size_t n = 0;
-            while ((n = retval.find(key, n)) != std::string::npos) {
-                retval.replace(n, key.size(), value);
-                n += value.size();
-            }
+            replaceVariable(retval, key, value);
         }
     }
     return retval;
@@ -0,0 +1,416 @@
+/*  =========================================================================
+    fty_common_translation_stream - Streaming translation of JSON documents
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "fty_common_translation_stream.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <future>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include <fty_log.h>
+
+#define KEY "key"
+
+namespace {
+
+// part of the document, either copied as is or translatable object
+struct Segment
+{
+    bool        translatable;
+    std::string data;
+};
+
+using Chunk = std::vector<Segment>;
+
+// Splits the document into literal text and translatable objects. Only the object currently being read is buffered,
+// everything else goes directly to the chunk, so memory is bounded by chunk and object size.
+class Scanner
+{
+public:
+    Scanner(size_t max_object_size)
+        : max_object_size_(max_object_size)
+    {
+    }
+
+    void feed(const char* data, size_t size);
+
+    // flush the rest of the document, incomplete object is kept untranslated
+    Chunk finish()
+    {
+        flushPending();
+        return take();
+    }
+
+    Chunk take()
+    {
+        Chunk retval;
+        retval.swap(chunk_);
+        chunk_size_ = 0;
+        return retval;
+    }
+
+    size_t size() const
+    {
+        return chunk_size_;
+    }
+
+private:
+    enum State
+    {
+        Text,
+        TextString,
+        TextStringEscape,
+        // '{' read, waiting for first key
+        Open,
+        // reading first key, matched_ characters of "key" matched so far
+        OpenKey,
+        // inside translatable object, depth_ levels deep
+        Capture,
+        CaptureString,
+        CaptureStringEscape
+    };
+
+    size_t      max_object_size_;
+    State       state_   = Text;
+    size_t      matched_ = 0;
+    size_t      depth_   = 0;
+    std::string pending_;
+    Chunk       chunk_;
+    size_t      chunk_size_ = 0;
+
+    void appendLiteral(const char* data, size_t size)
+    {
+        if (size == 0) {
+            return;
+        }
+        if (chunk_.empty() || chunk_.back().translatable) {
+            chunk_.push_back({false, std::string()});
+        }
+        chunk_.back().data.append(data, size);
+        chunk_size_ += size;
+    }
+
+    void flushPending()
+    {
+        appendLiteral(pending_.data(), pending_.size());
+        pending_.clear();
+    }
+};
+
+
+void Scanner::feed(const char* data, size_t size)
+{
+    const char* end = data + size;
+    while (data != end) {
+        switch (state_) {
+            case Text: {
+                // copy everything up to the next string or object at once
+                const char* next = data;
+                while (next != end && *next != '"' && *next != '{') {
+                    ++next;
+                }
+                appendLiteral(data, size_t(next - data));
+                data = next;
+                if (data == end) {
+                    break;
+                }
+                if (*data == '"') {
+                    appendLiteral(data, 1);
+                    state_ = TextString;
+                } else {
+                    pending_.assign(1, '{');
+                    state_ = Open;
+                }
+                ++data;
+                break;
+            }
+            case TextString: {
+                const char* next = data;
+                while (next != end && *next != '"' && *next != '\\') {
+                    ++next;
+                }
+                if (next != end) {
+                    state_ = (*next == '"') ? Text : TextStringEscape;
+                    ++next;
+                }
+                appendLiteral(data, size_t(next - data));
+                data = next;
+                break;
+            }
+            case TextStringEscape:
+                appendLiteral(data, 1);
+                state_ = TextString;
+                ++data;
+                break;
+            case Open: {
+                char c = *data++;
+                pending_ += c;
+                if (c == '"') {
+                    matched_ = 0;
+                    state_   = OpenKey;
+                } else if (!isspace(static_cast<unsigned char>(c))) {
+                    // not an object with "key" as a first member
+                    flushPending();
+                    state_ = Text;
+                }
+                break;
+            }
+            case OpenKey: {
+                char c = *data++;
+                pending_ += c;
+                if (c == '"' && matched_ == strlen(KEY)) {
+                    depth_ = 1;
+                    state_ = Capture;
+                } else if (c != '"' && matched_ < strlen(KEY) && c == KEY[matched_]) {
+                    ++matched_;
+                } else {
+                    // first member is something else, continue with the rest of the member name as a text
+                    flushPending();
+                    state_ = (c == '"') ? Text : ((c == '\\') ? TextStringEscape : TextString);
+                }
+                break;
+            }
+            case Capture:
+            case CaptureString:
+            case CaptureStringEscape: {
+                char c = *data++;
+                pending_ += c;
+                if (state_ == CaptureStringEscape) {
+                    state_ = CaptureString;
+                } else if (state_ == CaptureString) {
+                    if (c == '\\') {
+                        state_ = CaptureStringEscape;
+                    } else if (c == '"') {
+                        state_ = Capture;
+                    }
+                } else if (c == '"') {
+                    state_ = CaptureString;
+                } else if (c == '{') {
+                    ++depth_;
+                } else if (c == '}' && --depth_ == 0) {
+                    chunk_size_ += pending_.size();
+                    chunk_.push_back({true, std::move(pending_)});
+                    pending_.clear();
+                    state_ = Text;
+                    break;
+                }
+                if (pending_.size() > max_object_size_) {
+                    // too big to be buffered, keep it untranslated and look for translatable objects inside
+                    log_debug("Translatable object exceeds %zu bytes, keeping it untranslated", max_object_size_);
+                    flushPending();
+                    state_ = (state_ == Capture) ? Text : ((state_ == CaptureString) ? TextString : TextStringEscape);
+                }
+                break;
+            }
+        }
+    }
+}
+
+} // namespace
+
+
+// translated text keeps escape sequences of both translation file and variables, only characters expanded during
+// loading of translation file (new lines) need to be escaped again
+static void appendJsonString(std::string& target, const std::string& value)
+{
+    static const char hex[] = "0123456789abcdef";
+    target += '"';
+    for (char c : value) {
+        switch (c) {
+            case '\n':
+                target += "\\n";
+                break;
+            case '\r':
+                target += "\\r";
+                break;
+            case '\t':
+                target += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    target += "\\u00";
+                    target += hex[(c >> 4) & 0xf];
+                    target += hex[c & 0xf];
+                } else {
+                    target += c;
+                }
+        }
+    }
+    target += '"';
+}
+
+
+static std::string translateChunk(
+    const Chunk& chunk, const TRANSLATION_CONFIGURATION& conf, std::atomic<size_t>& translated)
+{
+    std::string retval;
+    size_t      count = 0;
+    for (const auto& segment : chunk) {
+        if (!segment.translatable) {
+            retval += segment.data;
+            continue;
+        }
+        try {
+            appendJsonString(retval, Translation::getInstance().getTranslatedText(conf, segment.data));
+            ++count;
+        } catch (Translation::LanguageNotLoadedException&) {
+            throw;
+        } catch (...) {
+            // keep original object, so no information is lost in the output
+            log_debug("Unable to translate '%s', keeping it untranslated", segment.data.c_str());
+            retval += segment.data;
+        }
+    }
+    translated += count;
+    return retval;
+}
+
+
+TranslationStream::TranslationStream(
+    const std::string& language, size_t threads, size_t chunk_size, size_t max_object_size)
+    : language_(language)
+    , threads_(threads)
+    , chunk_size_(chunk_size)
+    , max_object_size_(max_object_size)
+    , translated_(0)
+{
+    if (threads_ == 0) {
+        threads_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (chunk_size_ == 0) {
+        chunk_size_ = DEFAULT_CHUNK_SIZE;
+    }
+}
+
+
+size_t TranslationStream::translate(std::istream& input, std::ostream& output)
+{
+    return translate(
+        [&input](char* buffer, size_t size) -> size_t {
+            input.read(buffer, std::streamsize(size));
+            if (input.bad()) {
+                throw IOException();
+            }
+            return size_t(input.gcount());
+        },
+        [&output](const std::string& data) {
+            if (!output.write(data.data(), std::streamsize(data.size()))) {
+                throw IOException();
+            }
+        });
+}
+
+
+size_t TranslationStream::translate(int input_fd, int output_fd)
+{
+    return translate(
+        [input_fd](char* buffer, size_t size) -> size_t {
+            ssize_t rv;
+            while ((rv = ::read(input_fd, buffer, size)) < 0 && errno == EINTR) {
+            }
+            if (rv < 0) {
+                log_error("Unable to read translation input: %s", strerror(errno));
+                throw IOException();
+            }
+            return size_t(rv);
+        },
+        [output_fd](const std::string& data) {
+            size_t done = 0;
+            while (done < data.size()) {
+                ssize_t rv = ::write(output_fd, data.data() + done, data.size() - done);
+                if (rv < 0 && errno == EINTR) {
+                    continue;
+                }
+                if (rv < 0) {
+                    log_error("Unable to write translation output: %s", strerror(errno));
+                    throw IOException();
+                }
+                done += size_t(rv);
+            }
+        });
+}
+
+
+size_t TranslationStream::translate(
+    const std::function<size_t(char*, size_t)>& read, const std::function<void(const std::string&)>& write)
+{
+    // fail before anything is read or written
+    Translation::getInstance().findLanguage(language_);
+
+    TRANSLATION_CONFIGURATION conf = {const_cast<char*>(language_.c_str())};
+    Scanner                   scanner(max_object_size_);
+    std::vector<char>         buffer(chunk_size_);
+    // chunks being translated, in input order
+    std::deque<std::future<std::string>> in_flight;
+
+    translated_ = 0;
+    auto submit = [&](Chunk&& chunk) {
+        if (threads_ == 1) {
+            write(translateChunk(chunk, conf, translated_));
+            return;
+        }
+        // keep at most two chunks per thread in memory
+        if (in_flight.size() >= threads_ * 2) {
+            write(in_flight.front().get());
+            in_flight.pop_front();
+        }
+        in_flight.push_back(std::async(std::launch::async, [this, &conf, chunk = std::move(chunk)]() {
+            return translateChunk(chunk, conf, translated_);
+        }));
+    };
+
+    size_t size;
+    while ((size = read(buffer.data(), buffer.size())) > 0) {
+        scanner.feed(buffer.data(), size);
+        if (scanner.size() >= chunk_size_) {
+            submit(scanner.take());
+        }
+    }
+    submit(scanner.finish());
+    while (!in_flight.empty()) {
+        write(in_flight.front().get());
+        in_flight.pop_front();
+    }
+    return translated_;
+}
+
+
+int translation_translate_stream(const char* language, int input_fd, int output_fd, size_t threads)
+{
+    if (nullptr == language) {
+        return TE_Undefined;
+    }
+
+    try {
+        TranslationStream(language, threads).translate(input_fd, output_fd);
+    } catch (Translation::LanguageNotLoadedException&) {
+        log_error("Language '%s' is not loaded", language);
+        return TE_LanguageNotLoaded;
+    } catch (...) {
+        log_error("Undefined error in stream translation");
+        return TE_Undefined;
+    }
+    return TE_OK;
+}
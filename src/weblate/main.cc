@@ -0,0 +1,205 @@
+/*  =========================================================================
+    fty-translation-weblate - Push strings to Weblate and get translations back
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "weblate.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <glob.h>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+static const char* program = "fty-translation-weblate";
+
+static void usage()
+{
+    std::cerr << "Usage:\n"
+              << "  " << program << " export [-o BE_weblate.json] [file.tsl ...]\n"
+              << "      merge translation string lists (default *.tsl) into Weblate file\n"
+              << "  " << program << " import [-p prefix] [-d path] <language> <weblate.json>\n"
+              << "      write translated Weblate file as <path>/<prefix><language>.json" << std::endl;
+}
+
+
+// read whole file at once, returns false if it doesn't exist
+static bool readFile(const std::string& filename, std::string& content)
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file) {
+        return false;
+    }
+    content.resize(size_t(file.tellg()));
+    file.seekg(0);
+    return bool(file.read(&content[0], std::streamsize(content.size())));
+}
+
+
+// replace file atomically
+static bool writeFile(const std::string& filename, const std::string& content)
+{
+    std::string   tmp = filename + ".tmp";
+    std::ofstream file(tmp, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.write(content.data(), std::streamsize(content.size())) || (file.close(), !file)) {
+        std::cerr << "Unable to write '" << tmp << "': " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (rename(tmp.c_str(), filename.c_str()) != 0) {
+        std::cerr << "Unable to rename '" << tmp << "' to '" << filename << "': " << strerror(errno) << std::endl;
+        unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+
+static int exportStrings(int argc, char** argv)
+{
+    std::string output = "BE_weblate.json";
+    int         opt;
+    while ((opt = getopt(argc, argv, "o:")) != -1) {
+        if (opt != 'o') {
+            usage();
+            return 1;
+        }
+        output = optarg;
+    }
+
+    std::vector<std::string> files(argv + optind, argv + argc);
+    if (files.empty()) {
+        glob_t matches;
+        int    result = glob("*.tsl", 0, nullptr, &matches);
+        if (result == 0) {
+            files.assign(matches.gl_pathv, matches.gl_pathv + matches.gl_pathc);
+        }
+        globfree(&matches);
+        // existing Weblate file would be emptied otherwise
+        if (result != 0) {
+            std::cerr << (result == GLOB_NOMATCH ? "No *.tsl file found" : "Unable to list *.tsl files") << std::endl;
+            return 1;
+        }
+    }
+
+    Weblate::Collector collector;
+    for (const auto& filename : files) {
+        std::ifstream file(filename, std::ios::in | std::ios::binary);
+        if (!file) {
+            std::cerr << "Unable to read '" << filename << "'" << std::endl;
+            return 1;
+        }
+        collector.add(file);
+    }
+
+    Weblate::Entries existing;
+    std::string      current;
+    if (readFile(output, current)) {
+        try {
+            existing = Weblate::read(current);
+        } catch (Weblate::CorruptedFileException&) {
+            std::cerr << "Existing '" << output << "' is corrupted, it will be rewritten" << std::endl;
+        }
+    }
+
+    size_t             added, removed;
+    std::ostringstream result;
+    Weblate::writeWeblate(result, Weblate::merge(existing, collector.entries(), added, removed));
+    // unchanged file is not touched at all
+    const std::string content = result.str();
+    if (content != current && !writeFile(output, content)) {
+        return 1;
+    }
+    std::cout << "Weblate file '" << output << "': " << added << " strings added, " << removed << " removed"
+              << std::endl;
+    return 0;
+}
+
+
+static int importTranslations(int argc, char** argv)
+{
+    std::string prefix, path;
+    int         opt;
+    while ((opt = getopt(argc, argv, "p:d:")) != -1) {
+        switch (opt) {
+            case 'p':
+                prefix = optarg;
+                break;
+            case 'd':
+                path = optarg;
+                break;
+            default:
+                usage();
+                return 1;
+        }
+    }
+    if (argc - optind != 2) {
+        usage();
+        return 1;
+    }
+    if (!path.empty() && path[path.length() - 1] != '/') {
+        path += '/';
+    }
+    std::string language = argv[optind];
+    std::string filename = argv[optind + 1];
+    std::string output   = path + prefix + language + ".json";
+
+    std::string      content, current;
+    Weblate::Entries entries;
+    if (!readFile(filename, content)) {
+        std::cerr << "Unable to read '" << filename << "'" << std::endl;
+        return 1;
+    }
+    try {
+        entries = Weblate::read(content);
+    } catch (Weblate::CorruptedFileException&) {
+        std::cerr << "Weblate file '" << filename << "' is corrupted" << std::endl;
+        return 1;
+    }
+
+    std::ostringstream result;
+    Weblate::writeLanguage(result, entries);
+    // unchanged file is not touched at all
+    if ((!readFile(output, current) || result.str() != current) && !writeFile(output, result.str())) {
+        return 1;
+    }
+    std::cout << "Translation file '" << output << "' written from '" << filename << "'" << std::endl;
+    return 0;
+}
+
+
+int main(int argc, char** argv)
+{
+    program = argv[0];
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+    // skip command, getopt() starts from argv[1]
+    if (strcmp(argv[1], "export") == 0) {
+        return exportStrings(argc - 1, argv + 1);
+    }
+    if (strcmp(argv[1], "import") == 0) {
+        return importTranslations(argc - 1, argv + 1);
+    }
+    usage();
+    return 1;
+}
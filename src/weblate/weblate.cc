@@ -0,0 +1,333 @@
+/*  =========================================================================
+    weblate - Conversion between translation string lists and Weblate files
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "weblate.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <unordered_map>
+
+#define TRANSLATE_LUA "TRANSLATE_LUA"
+
+static std::string readAll(std::istream& input)
+{
+    std::string retval;
+    char        buffer[64 * 1024];
+    while (input.read(buffer, sizeof(buffer)) || input.gcount() > 0) {
+        retval.append(buffer, size_t(input.gcount()));
+    }
+    return retval;
+}
+
+
+namespace {
+
+// Insert only set of views with open addressing, unlike std::unordered_set it allocates nothing per element, which
+// matters for millions of lines
+class ViewSet
+{
+public:
+    explicit ViewSet(size_t count)
+    {
+        size_t size = 16;
+        while (size < count * 2) {
+            size *= 2;
+        }
+        slots_.resize(size);
+    }
+
+    // returns false if the same text is already there
+    bool insert(std::string_view view)
+    {
+        size_t hash = std::hash<std::string_view>()(view);
+        size_t mask = slots_.size() - 1;
+        for (size_t i = hash & mask;; i = (i + 1) & mask) {
+            Slot& slot = slots_[i];
+            if (slot.view.data() == nullptr) {
+                slot = {hash, view};
+                return true;
+            }
+            if (slot.hash == hash && slot.view == view) {
+                return false;
+            }
+        }
+    }
+
+private:
+    struct Slot
+    {
+        size_t           hash;
+        std::string_view view;
+    };
+    // empty slots have null view
+    std::vector<Slot> slots_;
+};
+
+} // namespace
+
+
+void Weblate::Collector::add(std::istream& input)
+{
+    // read whole list at once, lines are then only referenced
+    const std::string& content = contents_.emplace_back(readAll(input));
+
+    size_t begin = 0;
+    while (begin < content.size()) {
+        size_t end = content.find('\n', begin);
+        if (end == std::string::npos) {
+            end = content.size();
+        }
+        lines_.emplace_back(content.data() + begin, end - begin);
+        begin = end + 1;
+    }
+}
+
+
+std::string_view Weblate::Collector::store(std::string_view text)
+{
+    // blocks never grow over their capacity, so views into them stay valid
+    if (converted_.empty() || converted_.back().capacity() - converted_.back().size() < text.size()) {
+        converted_.emplace_back().reserve(std::max<size_t>(1024 * 1024, text.size()));
+    }
+    std::string& block = converted_.back();
+    size_t       pos   = block.size();
+    block.append(text);
+    return std::string_view(block.data() + pos, text.size());
+}
+
+
+Weblate::Entries Weblate::Collector::entries()
+{
+    // drop duplicates first, then only unique lines are sorted, byte order is the same as sort in C locale
+    std::vector<std::string_view> unique;
+    {
+        ViewSet lines(lines_.size());
+        for (const auto& line : lines_) {
+            if (lines.insert(line)) {
+                unique.push_back(line);
+            }
+        }
+    }
+    std::sort(unique.begin(), unique.end());
+
+    Entries     retval;
+    ViewSet     keys(unique.size());
+    std::string buffer;
+    retval.reserve(unique.size());
+    for (const auto& line : unique) {
+        Entry entry = convert(line, buffer);
+        if (entry.first.data() == buffer.data()) {
+            entry.first = entry.second = store(entry.first);
+        } else if (entry.second.data() == buffer.data()) {
+            entry.second = store(entry.second);
+        }
+        // different lines may end up as the same key ("%s" and "%d"), keep the first one only, lines are unique
+        // otherwise so only keys with variables need to be checked
+        if (entry.first.find("{{var") != std::string_view::npos && !keys.insert(entry.first)) {
+            continue;
+        }
+        retval.push_back(entry);
+    }
+    return retval;
+}
+
+
+Weblate::Entry Weblate::convert(std::string_view line, std::string& buffer)
+{
+    buffer.clear();
+    if (line.compare(0, strlen(TRANSLATE_LUA), TRANSLATE_LUA) == 0) {
+        // TRANSLATE_LUA(text) -> text, key is kept as is
+        std::string_view text = line;
+        for (size_t pos = 0; (pos = line.find(TRANSLATE_LUA, pos)) != std::string_view::npos; ++pos) {
+            size_t end = line.find_first_not_of(' ', pos + strlen(TRANSLATE_LUA));
+            if (end != std::string_view::npos && line[end] == '(') {
+                if (pos == 0) {
+                    text = line.substr(end + 1);
+                } else {
+                    // text around the removed part has to be joined
+                    buffer.append(line.substr(0, pos)).append(line.substr(end + 1));
+                    text = buffer;
+                }
+                break;
+            }
+        }
+        if (!text.empty() && text.back() == ')') {
+            text.remove_suffix(1);
+        }
+        return {line, text};
+    }
+
+    // printf like arguments to numbered variables: "%s of % d" -> "{{var1}} of {{var2}}"
+    size_t arg_count = 1;
+    size_t begin     = 0;
+    for (size_t i = line.find('%'); i != std::string_view::npos; i = line.find('%', i + 1)) {
+        size_t next = i + 1;
+        if (next < line.size() && line[next] == ' ') {
+            ++next;
+        }
+        if (next < line.size() && line[next] != '\'' && line[next] != ' ') {
+            buffer.append(line.substr(begin, i - begin));
+            buffer += "{{var";
+            buffer += std::to_string(arg_count++);
+            buffer += "}}";
+            begin = next + 1;
+            i     = next;
+        }
+    }
+    if (arg_count == 1) {
+        return {line, line};
+    }
+    buffer.append(line.substr(begin));
+    return {buffer, buffer};
+}
+
+
+// read JSON string starting at opening quote, escape sequences are kept
+static std::string_view readString(const std::string& content, size_t& pos)
+{
+    if (pos >= content.size() || content[pos] != '"') {
+        throw Weblate::CorruptedFileException();
+    }
+    size_t begin = ++pos;
+    while ((pos = content.find('"', pos)) != std::string::npos) {
+        // quote is escaped by odd number of backslashes
+        size_t backslashes = 0;
+        while (pos - backslashes > begin && content[pos - backslashes - 1] == '\\') {
+            ++backslashes;
+        }
+        if (backslashes % 2 == 0) {
+            break;
+        }
+        ++pos;
+    }
+    if (pos == std::string::npos) {
+        throw Weblate::CorruptedFileException();
+    }
+    return std::string_view(content.data() + begin, pos++ - begin);
+}
+
+
+// skip white spaces and read next character
+static char readToken(const std::string& content, size_t& pos)
+{
+    while (pos < content.size() && isspace(static_cast<unsigned char>(content[pos]))) {
+        ++pos;
+    }
+    if (pos >= content.size()) {
+        throw Weblate::CorruptedFileException();
+    }
+    return content[pos];
+}
+
+
+Weblate::Entries Weblate::read(const std::string& content)
+{
+    Entries retval;
+    size_t  pos = 0;
+    if (readToken(content, pos) != '{') {
+        throw CorruptedFileException();
+    }
+    ++pos;
+    while (readToken(content, pos) != '}') {
+        std::string_view key = readString(content, pos);
+        if (readToken(content, pos) != ':') {
+            throw CorruptedFileException();
+        }
+        ++pos;
+        // only flat objects of strings are supported, readString() checks it
+        readToken(content, pos);
+        retval.emplace_back(key, readString(content, pos));
+        char c = readToken(content, pos);
+        if (c == ',') {
+            ++pos;
+        } else if (c != '}') {
+            throw CorruptedFileException();
+        }
+    }
+    return retval;
+}
+
+
+void Weblate::writeWeblate(std::ostream& output, const Entries& entries)
+{
+    // format file in big blocks, it's much faster than many small stream writes
+    std::string content = "{\n";
+    content.reserve(1024 * 1024 + 1024);
+    for (size_t i = 0; i < entries.size(); ++i) {
+        content += "\t\"";
+        content += entries[i].first;
+        content += "\": \"";
+        content += entries[i].second;
+        content += (i + 1 < entries.size()) ? "\",\n" : "\"\n";
+        if (content.size() >= 1024 * 1024) {
+            output.write(content.data(), std::streamsize(content.size()));
+            content.clear();
+        }
+    }
+    content += "}\n";
+    output.write(content.data(), std::streamsize(content.size()));
+}
+
+
+void Weblate::writeLanguage(std::ostream& output, const Entries& entries)
+{
+    // loadLanguage() reads one "key" : "text" pair per line
+    const char* separator = "";
+    output << "{";
+    for (const auto& entry : entries) {
+        if (!entry.second.empty()) {
+            output << separator << "\n\t\"" << entry.first << "\": \"" << entry.second << "\"";
+            separator = ",";
+        }
+    }
+    output << "\n}\n";
+}
+
+
+Weblate::Entries Weblate::merge(const Entries& existing, Entries collected, size_t& added, size_t& removed)
+{
+    // both lists are usually in the same order, so entries are matched one by one and the lookup table is built
+    // only when they differ
+    std::unordered_map<std::string_view, size_t> index;
+    size_t                                       next = 0, kept = 0;
+
+    added = 0;
+    for (auto& entry : collected) {
+        if (next >= existing.size() || existing[next].first != entry.first) {
+            if (index.empty()) {
+                index.reserve(existing.size());
+                for (size_t i = 0; i < existing.size(); ++i) {
+                    index.emplace(existing[i].first, i);
+                }
+            }
+            auto it = index.find(entry.first);
+            if (it == index.end()) {
+                ++added;
+                continue;
+            }
+            next = it->second;
+        }
+        entry.second = existing[next++].second;
+        ++kept;
+    }
+    removed = existing.size() - kept;
+    return collected;
+}
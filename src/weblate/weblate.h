@@ -0,0 +1,77 @@
+/*  =========================================================================
+    weblate - Conversion between translation string lists and Weblate files
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include <deque>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+class Weblate
+{
+public:
+    // "key" -> "text" pair, strings are kept JSON escaped and point into the content they were read or collected from
+    using Entry   = std::pair<std::string_view, std::string_view>;
+    using Entries = std::vector<Entry>;
+
+    // Collects lines of translation string lists (.tsl) produced by collect_translations.sh
+    class Collector
+    {
+    public:
+        // add all lines of one list
+        void add(std::istream& input);
+        // entries sorted by collected line, as sort | uniq | translations_to_weblate.awk produces them, they point
+        // into the collector so it must outlive them
+        Entries entries();
+
+    private:
+        // copy converted text to storage which is never reallocated
+        std::string_view store(std::string_view text);
+
+        // contents of added lists, lines_ point directly into them
+        std::deque<std::string> contents_;
+        // all lines including duplicates, they are dropped at once in entries()
+        std::vector<std::string_view> lines_;
+        // blocks of texts with renumbered variables
+        std::deque<std::string> converted_;
+    };
+
+    // convert collected line to Weblate entry, see translations_to_weblate.awk, entry points into line or into buffer
+    // when the text has to be rewritten
+    static Entry convert(std::string_view line, std::string& buffer);
+    // read flat JSON object of strings (Weblate file or <prefix><lang>.json), entries point into content, throws
+    // CorruptedFileException
+    static Entries read(const std::string& content);
+    // write Weblate file in translations_to_weblate.awk format
+    static void writeWeblate(std::ostream& output, const Entries& entries);
+    // write language file in format read by Translation::loadLanguage(), untranslated entries are skipped
+    static void writeLanguage(std::ostream& output, const Entries& entries);
+    // merge collected entries to existing ones, texts of kept entries are preserved and order follows collected
+    static Entries merge(const Entries& existing, Entries collected, size_t& added, size_t& removed);
+
+    class CorruptedFileException
+    {
+    };
+};
@@ -0,0 +1,122 @@
+/*  =========================================================================
+    fty_common_translation_message - Typed translation messages
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "fty_common_translation_message.h"
+#include "helpers.h"
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <iostream>
+
+using namespace std::literals;
+using translation::arg;
+using translation::message;
+using translation::translate;
+
+TEST_CASE("Translation message")
+{
+    configure();
+
+    // test case 1 - plain keys and variables
+    {
+        CHECK(translate("en_US", "first") == "first"s);
+        CHECK(translate("cs_CZ", "first") == "první"s);
+        CHECK(translate("cs_CZ", "second") == "second"s);
+        CHECK(translate("en_US", "third", arg("variable", "var1")) == "a string with a var1"s);
+        CHECK(translate("en_US", "fourth", arg("multiple", "var1"s), arg("nextvar", 42)) ==
+              "a string with var1 variables 42"s);
+        CHECK(translate("cs_CZ", "fifth", arg("var1", "v1"), arg("var2", "v2")) ==
+              "reverse order string with v2 and v1 variables"s);
+        CHECK(translate("en_US", "sixth", arg("variable", "var1")) == "multiple instances of var1, var1, var1"s);
+        CHECK(translate("en_US", "seventh") == "string without {{variable}} replacement"s);
+        CHECK(translate("en_US", "twelfth\nthirteenth") == "string\nwith\nnewlines"s);
+
+        // characters and bools are text, not numbers
+        CHECK(translate("en_US", "third", arg("variable", 'a')) == "a string with a a"s);
+        CHECK(translate("en_US", "third", arg("variable", true)) == "a string with a true"s);
+        CHECK(translate("en_US", "third", arg("variable", "var1"sv)) == "a string with a var1"s);
+        CHECK(translate("en_US", "fourth", arg("multiple", 1.5f), arg("nextvar", -1)) ==
+              "a string with 1.500000 variables -1"s);
+    }
+
+    // test case 2 - nested messages
+    {
+        CHECK(translate("en_US", "eleventh", arg("var1", message("ninth", arg("variable", message("eight")))),
+                  arg("var2", message("tenth"))) ==
+              "outer string with middle string with innermost string and second innermost string"s);
+        CHECK(translate("cs_CZ", "fifth", arg("var1", message("first")), arg("var2", "v2")) ==
+              "reverse order string with v2 and první variables"s);
+
+        TranslationMessage msg("third", {arg("variable", "var1")});
+        CHECK(Translation::getInstance().getTranslatedText("en_US", msg) == "a string with a var1"s);
+    }
+
+    // test case 3 - same results as JSON interface
+    {
+        TRANSLATION_CONFIGURATION config = {const_cast<char*>("cs_CZ")};
+        CHECK(translate("cs_CZ", "eleventh", arg("var1", message("ninth", arg("variable", message("eight")))),
+                  arg("var2", message("tenth"))) ==
+              Translation::getInstance().getTranslatedText(config,
+                  R"({ "key" : "eleventh", "variables" : { "var1" : { "key" : "ninth", "variables" : { "variable" : { "key" : "eight" }}}, "var2" : {"key" : "tenth"}}})"));
+    }
+
+    // test case 4 - failures
+    {
+        CHECK_THROWS_AS(translate("en_US", ""), Translation::TranslationNotFoundException);
+        CHECK_THROWS_AS(translate("en_US", "not found"), Translation::TranslationNotFoundException);
+        CHECK_THROWS_AS(translate("en_US", "third", arg("variable", message("not found"))),
+            Translation::TranslationNotFoundException);
+        CHECK_THROWS_AS(translate("fr_FR", "first"), Translation::LanguageNotLoadedException);
+    }
+}
+
+// run with: fty_common_translation_test "[benchmark]", FTY_TRANSLATION_BENCHMARK_COUNT overrides default count
+TEST_CASE("Translation message benchmark", "[.][benchmark]")
+{
+    configure();
+
+    size_t count = benchmarkParameter("FTY_TRANSLATION_BENCHMARK_COUNT", 1000000);
+    TRANSLATION_CONFIGURATION config = {const_cast<char*>("cs_CZ")};
+    const std::string         name   = "DC-Roztoky";
+    size_t                    size   = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        // what producers do today, serialize the message just to get it parsed back
+        std::string json = R"({ "key" : "eleventh", "variables" : { "var1" : { "key" : "ninth", "variables" : { "variable" : ")" +
+                           name + R"(" }}, "var2" : {"key" : "tenth"}}})";
+        size += Translation::getInstance().getTranslatedText(config, json).size();
+    }
+    std::chrono::duration<double> json_elapsed = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        size -= translate("cs_CZ", "eleventh", arg("var1", message("ninth", arg("variable", name))),
+            arg("var2", message("tenth")))
+                    .size();
+    }
+    std::chrono::duration<double> typed_elapsed = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Translation of " << count << " messages, JSON: " << json_elapsed.count() << " s ("
+              << json_elapsed.count() * 1e9 / double(count) << " ns/msg), typed: " << typed_elapsed.count() << " s ("
+              << typed_elapsed.count() * 1e9 / double(count) << " ns/msg), speedup "
+              << json_elapsed.count() / typed_elapsed.count() << "x" << std::endl;
+    CHECK(size == 0);
+}
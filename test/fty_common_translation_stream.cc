@@ -0,0 +1,197 @@
+/*  =========================================================================
+    fty_common_translation_stream - Streaming translation of JSON documents
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "fty_common_translation_stream.h"
+#include "helpers.h"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+using namespace std::literals;
+
+static std::string translate(const std::string& input, const std::string& language = "en_US", size_t threads = 1,
+    size_t chunk_size = TranslationStream::DEFAULT_CHUNK_SIZE,
+    size_t max_object_size = TranslationStream::DEFAULT_MAX_OBJECT_SIZE)
+{
+    std::istringstream in(input);
+    std::ostringstream out;
+    TranslationStream(language, threads, chunk_size, max_object_size).translate(in, out);
+    return out.str();
+}
+
+TEST_CASE("Translation stream")
+{
+    configure();
+
+    // test case 1 - translatable objects anywhere in the document
+    {
+        CHECK(translate(R"({"key" : "first"})") == R"("first")"s);
+        CHECK(translate(R"({"key" : "first"})", "cs_CZ") == R"("první")"s);
+        CHECK(translate(R"([{"key":"first"}, {"key":"second"}])") == R"(["first", "second"])"s);
+        CHECK(translate(R"({"id" : 1, "alert" : { "msg" : {"key" : "third", "variables" : { "variable" : "var1"}}}})") ==
+              R"({"id" : 1, "alert" : { "msg" : "a string with a var1"}})"s);
+        CHECK(translate(R"({"msg" : { "key" : "eleventh", "variables" : { "var1" : { "key" : "ninth", "variables" : { "variable" : { "key" : "eight" }}}, "var2" : {"key" : "tenth"}}}})") ==
+              R"({"msg" : "outer string with middle string with innermost string and second innermost string"})"s);
+        CHECK(translate(R"b({"key" : "TRANSLATE_LUA(Phase imbalance in datacenter {{ename}} is high.)", "variables" : {"ename" : {"value" : "DC \"Roztoky\"", "assetLink" : "datacenter-3"}}})b") ==
+              R"("Phase imbalance in datacenter DC \"Roztoky\" is high.")"s);
+    }
+
+    // test case 2 - everything else is copied as is
+    {
+        std::string input;
+
+        input = R"({"id" : 1, "name" : "{\"key\" : \"first\"}", "keys" : ["key", "{"]})";
+        CHECK(translate(input) == input);
+        input = R"({"keyword" : "first", "a" : {"kex" : 1}, "b" : {}, "c" : { }, "d" : {"k\"ey" : 2}})";
+        CHECK(translate(input) == input);
+        input = R"({"key" : "not found"})";
+        CHECK(translate(input) == input);
+        input = R"({"key" : "third", "variables" : "corrupted"})";
+        CHECK(translate(input) == input);
+        input = R"([{"key" : "first"}, {"key" : "incomplete")";
+        CHECK(translate(input) == R"(["first", {"key" : "incomplete")"s);
+        CHECK(translate("") == ""s);
+    }
+
+    // test case 3 - objects bigger than limit are kept, smaller ones inside are still translated
+    {
+        std::string input = R"({"key" : "third", "variables" : { "variable" : {"key" : "first"}}})";
+        CHECK(translate(input, "en_US", 1, 1024, 32) == R"({"key" : "third", "variables" : { "variable" : "first"}})"s);
+    }
+
+    // test case 4 - chunked and parallel translation keeps order
+    {
+        std::string input, expected;
+        for (int i = 0; i < 1000; ++i) {
+            input += R"({"id" : )" + std::to_string(i) + R"(, "msg" : {"key" : "fifth", "variables" : { "var1" : ")" +
+                     std::to_string(i) + R"(", "var2" : {"key" : "first"}}}})" + "\n";
+            expected += R"({"id" : )" + std::to_string(i) + R"(, "msg" : "reverse order string with první and )" +
+                        std::to_string(i) + R"( variables"})" + "\n";
+        }
+        CHECK(translate(input, "cs_CZ", 1, 7) == expected);
+        CHECK(translate(input, "cs_CZ", 4, 7) == expected);
+        CHECK(translate(input, "cs_CZ", 0, 1000) == expected);
+    }
+
+    // test case 5 - file descriptors and C interface
+    {
+        int in[2], out[2];
+        REQUIRE(pipe(in) == 0);
+        REQUIRE(pipe(out) == 0);
+        std::string input = R"([{"key" : "first"}])";
+        REQUIRE(write(in[1], input.data(), input.size()) == ssize_t(input.size()));
+        close(in[1]);
+        CHECK(TE_OK == translation_translate_stream("cs_CZ", in[0], out[1], 2));
+        close(out[1]);
+        char    buffer[64];
+        ssize_t size = read(out[0], buffer, sizeof(buffer));
+        CHECK(std::string(buffer, size_t(std::max(ssize_t(0), size))) == R"(["první"])"s);
+        close(in[0]);
+        close(out[0]);
+    }
+
+    // test case 6 - language must be loaded
+    {
+        CHECK_THROWS_AS(translate(R"({"key" : "first"})", "fr_FR"), Translation::LanguageNotLoadedException);
+        CHECK_THROWS_AS(translate(R"({"id" : 1})", "fr_FR"), Translation::LanguageNotLoadedException);
+
+        // nothing is written, even when the first translatable object is chunks away
+        std::istringstream in(std::string(100, ' ') + R"({"key" : "first"})");
+        std::ostringstream out;
+        CHECK_THROWS_AS(TranslationStream("fr_FR", 1, 10).translate(in, out), Translation::LanguageNotLoadedException);
+        CHECK(out.str().empty());
+        CHECK(TE_LanguageNotLoaded == translation_translate_stream("fr_FR", -1, -1, 1));
+    }
+}
+
+// generates export of alert history like records up to requested size
+class ExportGenerator : public std::streambuf
+{
+public:
+    ExportGenerator(size_t size)
+        : remaining_(size)
+    {
+    }
+
+private:
+    size_t      remaining_;
+    size_t      id_ = 0;
+    std::string record_;
+
+    int_type underflow() override
+    {
+        if (remaining_ == 0) {
+            return traits_type::eof();
+        }
+        record_ = R"({"id" : )" + std::to_string(id_++) +
+                  R"b(, "severity" : "CRITICAL", "asset" : "datacenter-3", "description" : {"key" : "TRANSLATE_LUA(Phase imbalance in datacenter {{ename}} is high.)", "variables" : {"ename" : {"value" : "DC-Roztoky", "assetLink" : "datacenter-3"}}}, "action" : {"key" : "fifth", "variables" : { "var1" : "v1", "var2" : {"key" : "first"}}}})b" +
+                  "\n";
+        record_.resize(std::min(record_.size(), remaining_));
+        remaining_ -= record_.size();
+        setg(&record_[0], &record_[0], &record_[0] + record_.size());
+        return traits_type::to_int_type(record_[0]);
+    }
+};
+
+// counts written bytes only
+class NullOutput : public std::streambuf
+{
+public:
+    size_t size = 0;
+
+private:
+    std::streamsize xsputn(const char*, std::streamsize count) override
+    {
+        size += size_t(count);
+        return count;
+    }
+    int_type overflow(int_type c) override
+    {
+        ++size;
+        return c;
+    }
+};
+
+// run with: fty_common_translation_test "[benchmark]", FTY_TRANSLATION_BENCHMARK_SIZE overrides default size of 1 GB
+TEST_CASE("Translation stream benchmark", "[.][benchmark]")
+{
+    configure();
+
+    size_t size = benchmarkParameter("FTY_TRANSLATION_BENCHMARK_SIZE", 1024 * 1024 * 1024);
+    for (size_t threads : {size_t(1), size_t(0)}) {
+        ExportGenerator generator(size);
+        NullOutput      null;
+        std::istream    input(&generator);
+        std::ostream    output(&null);
+        auto            start      = std::chrono::steady_clock::now();
+        size_t          translated = TranslationStream("cs_CZ", threads).translate(input, output);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Translation stream, threads " << (threads ? threads : std::thread::hardware_concurrency())
+                  << ": " << size / (1024 * 1024) << " MB in " << elapsed.count() << " s, "
+                  << double(size) / (1024 * 1024) / elapsed.count() << " MB/s, " << translated
+                  << " objects translated, " << null.size << " bytes written" << std::endl;
+        CHECK(translated > 0);
+    }
+}
@@ -0,0 +1,229 @@
+/*  =========================================================================
+    weblate - Conversion between translation string lists and Weblate files
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#include "../src/weblate/weblate.h"
+#include "helpers.h"
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+using namespace std::literals;
+
+// entries point into their collector, collectors are kept until the end of tests
+static Weblate::Entries collect(const std::string& input)
+{
+    static std::deque<Weblate::Collector> collectors;
+    std::istringstream                    stream(input);
+    collectors.emplace_back().add(stream);
+    return collectors.back().entries();
+}
+
+static std::pair<std::string, std::string> convert(std::string_view line)
+{
+    std::string buffer;
+    auto        entry = Weblate::convert(line, buffer);
+    return {std::string(entry.first), std::string(entry.second)};
+}
+
+// read whole file at once as fty-translation-weblate does, missing file is empty
+static std::string readFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary | std::ios::ate);
+    std::string   content;
+    if (file) {
+        content.resize(size_t(file.tellg()));
+        file.seekg(0);
+        file.read(&content[0], std::streamsize(content.size()));
+    }
+    return content;
+}
+
+static std::string weblate(const Weblate::Entries& entries)
+{
+    std::ostringstream stream;
+    Weblate::writeWeblate(stream, entries);
+    return stream.str();
+}
+
+TEST_CASE("Translation weblate")
+{
+    // test case 1 - conversion of collected strings, see translations_to_weblate.awk
+    {
+        using Entry = std::pair<std::string, std::string>;
+        CHECK(convert("plain text") == Entry("plain text", "plain text"));
+        CHECK(convert("%s of %d") == Entry("{{var1}} of {{var2}}", "{{var1}} of {{var2}}"));
+        // same as awk, "% d" is an argument too
+        CHECK(convert("100 % done, % s left") ==
+              Entry("100 {{var1}}one, {{var2}} left", "100 {{var1}}one, {{var2}} left"));
+        CHECK(convert("'%' %'s") == Entry("'%' %'s", "'%' %'s"));
+        CHECK(convert("ends with %") == Entry("ends with %", "ends with %"));
+        CHECK(convert("TRANSLATE_LUA(Phase imbalance in datacenter {{ename}} is high.)") ==
+              Entry("TRANSLATE_LUA(Phase imbalance in datacenter {{ename}} is high.)",
+                  "Phase imbalance in datacenter {{ename}} is high."));
+        CHECK(convert("TRANSLATE_LUA  (%s)") == Entry("TRANSLATE_LUA  (%s)", "%s"));
+        CHECK(convert("TRANSLATE_LUA TRANSLATE_LUA (text)") ==
+              Entry("TRANSLATE_LUA TRANSLATE_LUA (text)", "TRANSLATE_LUA text"));
+    }
+
+    // test case 2 - duplicates are dropped and output is sorted
+    {
+        CHECK(weblate(collect("")) == "{\n}\n"s);
+        // order is given by collected lines, not by keys
+        CHECK(weblate(collect("b\na\nb\n%d\n%s\n")) ==
+              "{\n\t\"{{var1}}\": \"{{var1}}\",\n\t\"a\": \"a\",\n\t\"b\": \"b\"\n}\n"s);
+        CHECK(weblate(collect("{{var1}}\n%s\n")) == "{\n\t\"{{var1}}\": \"{{var1}}\"\n}\n"s);
+
+        Weblate::Collector collector;
+        std::istringstream first("second\nfirst\n"), second("third\nfirst");
+        collector.add(first);
+        collector.add(second);
+        CHECK(weblate(collector.entries()) ==
+              "{\n\t\"first\": \"first\",\n\t\"second\": \"second\",\n\t\"third\": \"third\"\n}\n"s);
+    }
+
+    // test case 3 - reading flat JSON objects
+    {
+        CHECK(Weblate::read("{}").empty());
+        CHECK(Weblate::read(weblate(collect("b\na\n"))) == collect("a\nb\n"));
+        const std::string content = R"({
+    "first": "první",
+    "with \"quotes\"" : "s \"uvozovkami\"",
+    "twelfth\nthirteenth":"",
+    "fifth": "reverse order string with {{var2}} and {{var1}} variables"
+})";
+        auto entries = Weblate::read(content);
+        REQUIRE(entries.size() == 4);
+        CHECK(entries[0] == Weblate::Entry("first", "první"));
+        CHECK(entries[1] == Weblate::Entry(R"(with \"quotes\")", R"(s \"uvozovkami\")"));
+        CHECK(entries[2] == Weblate::Entry(R"(twelfth\nthirteenth)", ""));
+
+        CHECK_THROWS_AS(Weblate::read(""), Weblate::CorruptedFileException);
+        CHECK_THROWS_AS(Weblate::read("{"), Weblate::CorruptedFileException);
+        CHECK_THROWS_AS(Weblate::read(R"({"a": "b")"), Weblate::CorruptedFileException);
+        CHECK_THROWS_AS(Weblate::read(R"({"a": "b" "c": "d"})"), Weblate::CorruptedFileException);
+        CHECK_THROWS_AS(Weblate::read(R"({"a": {"b": "c"}})"), Weblate::CorruptedFileException);
+        CHECK_THROWS_AS(Weblate::read(R"({"a": 1})"), Weblate::CorruptedFileException);
+
+        // language file keeps one pair per line and skips untranslated strings
+        std::ostringstream language;
+        Weblate::writeLanguage(language, entries);
+        CHECK(language.str() ==
+              "{\n\t\"first\": \"první\",\n\t\"with \\\"quotes\\\"\": \"s \\\"uvozovkami\\\"\",\n"
+              "\t\"fifth\": \"reverse order string with {{var2}} and {{var1}} variables\"\n}\n"s);
+        CHECK(Weblate::read(language.str()).size() == 3);
+    }
+
+    // test case 4 - incremental merge
+    {
+        size_t            added, removed;
+        const std::string content  = "{\n\t\"a\": \"edited a\",\n\t\"b\": \"b\",\n\t\"c\": \"c\"\n}\n";
+        auto              existing = Weblate::read(content);
+
+        auto merged = Weblate::merge(existing, collect("c\na\nb\n"), added, removed);
+        CHECK(added == 0);
+        CHECK(removed == 0);
+        CHECK(weblate(merged) == "{\n\t\"a\": \"edited a\",\n\t\"b\": \"b\",\n\t\"c\": \"c\"\n}\n"s);
+
+        merged = Weblate::merge(existing, collect("c\nd\na\n"), added, removed);
+        CHECK(added == 1);
+        CHECK(removed == 1);
+        CHECK(weblate(merged) == "{\n\t\"a\": \"edited a\",\n\t\"c\": \"c\",\n\t\"d\": \"d\"\n}\n"s);
+
+        merged = Weblate::merge({}, collect("a\n"), added, removed);
+        CHECK(added == 1);
+        CHECK(removed == 0);
+    }
+}
+
+// run with: fty_common_translation_test "[benchmark]", FTY_TRANSLATION_BENCHMARK_LINES overrides default line count,
+// FTY_TRANSLATION_WEBLATE_SCRIPT points to translations_to_weblate.sh to compare with
+TEST_CASE("Translation weblate benchmark", "[.][benchmark]")
+{
+    size_t lines = benchmarkParameter("FTY_TRANSLATION_BENCHMARK_LINES", 2000000);
+    char dir[] = "/tmp/fty-translation-weblate-XXXXXX";
+    REQUIRE(mkdtemp(dir) != nullptr);
+    const std::string path = dir;
+
+    // synthetic translation string lists from several agents, a lot of strings are shared
+    const size_t files = 16;
+    for (size_t f = 0; f < files; ++f) {
+        std::ofstream tsl(path + "/agent" + std::to_string(f) + ".tsl");
+        for (size_t i = f; i < lines; i += files) {
+            size_t id = (i * 7919) % (lines / 2 + 1);
+            if (id % 5 == 0) {
+                tsl << "TRANSLATE_LUA(Alert " << id << " on {{ename}} is active)\n";
+            } else {
+                tsl << "Request " << id << " for asset %s failed with error '%d'\n";
+            }
+        }
+    }
+
+    // the same steps as fty-translation-weblate export does
+    auto exportStrings = [&](size_t& added, size_t& removed) {
+        Weblate::Collector collector;
+        for (size_t f = 0; f < files; ++f) {
+            std::ifstream tsl(path + "/agent" + std::to_string(f) + ".tsl");
+            collector.add(tsl);
+        }
+        std::string      current = readFile(path + "/native.json");
+        Weblate::Entries existing;
+        if (!current.empty()) {
+            existing = Weblate::read(current);
+        }
+        std::ostringstream result;
+        Weblate::writeWeblate(result, Weblate::merge(existing, collector.entries(), added, removed));
+        const std::string content = result.str();
+        if (content != current) {
+            std::ofstream(path + "/native.json") << content;
+        }
+    };
+
+    size_t added, removed;
+    auto   start = std::chrono::steady_clock::now();
+    exportStrings(added, removed);
+    std::chrono::duration<double> native_elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Weblate export of " << lines << " lines (" << added << " unique), native: " << native_elapsed.count()
+              << " s" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    exportStrings(added, removed);
+    std::chrono::duration<double> incremental_elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Weblate export of " << lines << " lines, native incremental: " << incremental_elapsed.count() << " s"
+              << std::endl;
+    CHECK(added == 0);
+    CHECK(removed == 0);
+
+    if (const char* script = getenv("FTY_TRANSLATION_WEBLATE_SCRIPT")) {
+        std::string command = "cd '" + path + "' && '" + script + "' '*.tsl' script.json >/dev/null";
+        start               = std::chrono::steady_clock::now();
+        CHECK(system(command.c_str()) == 0);
+        std::chrono::duration<double> script_elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "Weblate export of " << lines << " lines, script: " << script_elapsed.count() << " s, speedup "
+                  << script_elapsed.count() / native_elapsed.count() << "x" << std::endl;
+        CHECK(readFile(path + "/native.json") == readFile(path + "/script.json"));
+    }
+    CHECK(system(("rm -rf '" + path + "'").c_str()) == 0);
+}
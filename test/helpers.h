@@ -0,0 +1,45 @@
+/*  =========================================================================
+    helpers - Shared helpers of translation tests
+
+    Copyright (C) 2014 - 2020 Eaton
+
+    This program is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program; if not, write to the Free Software Foundation, Inc.,
+    51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+    =========================================================================
+*/
+
+#pragma once
+
+#include "fty_common_translation_base.h"
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <string>
+
+// load test/data translations with en_US and cs_CZ, translation is singleton, it may be already configured by other
+// test case
+inline void configure()
+{
+    if (TE_OK != translation_change_language("cs_CZ")) {
+        REQUIRE_NOTHROW(Translation::getInstance().configure("translation_test", "test/data", "test_"));
+        REQUIRE(TE_OK == translation_change_language("cs_CZ"));
+    }
+    REQUIRE(TE_OK == translation_change_language("en_US"));
+}
+
+// size or count of benchmark, can be overridden by environment variable
+inline size_t benchmarkParameter(const char* env, size_t default_value)
+{
+    const char* value = getenv(env);
+    return value ? std::stoul(value) : default_value;
+}